@@ -0,0 +1,76 @@
+#include "parser.hpp"
+#include "scan.hpp"
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+namespace {
+
+namespace pegtl = TAO_PEGTL_NAMESPACE;
+namespace grammar = STDLParser::grammar;
+
+using Clock = std::chrono::steady_clock;
+
+std::string commentHeavyBlank(size_t lines){
+    std::string s;
+    for(size_t i = 0; i < lines; ++i){
+        s += "        // Lorem ipsum dolor sit amet, consectetur adipiscing elit ";
+        s += std::to_string(i);
+        s += "\n\t\t    \r\n";
+    }
+    return s;
+}
+
+std::string stringHeavyBody(size_t chunks){
+    std::string s;
+    for(size_t i = 0; i < chunks; ++i){
+        s += "The quick brown fox jumps over the lazy dog, again and again. ";
+        if(i % 8 == 7) s += "\\n\\t\\\"";
+    }
+    return s;
+}
+
+// Bytes per second for parsing all of input with Rule on input type Input.
+template<typename Rule, typename Input>
+double throughput(const std::string& input, int reps){
+    auto start = Clock::now();
+    for(int r = 0; r < reps; ++r){
+        Input in(input.data(), input.size(), "bench");
+        if(!pegtl::parse<pegtl::seq<Rule, pegtl::eof>>(in)){
+            std::cerr << "rule stopped before end of input\n";
+            return 0.0;
+        }
+    }
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+    return static_cast<double>(input.size()) * reps / elapsed.count();
+}
+
+// Old: the PEGTL rule the parser used before, on the eager input it used.
+// New: the scanner-backed rule on the lazy input the parser uses now, once
+// with the scalar fallback and once with the SIMD scanner.
+template<typename OldRule, const char* (*Scalar)(const char*, const char*), typename NewRule>
+void report(const char* label, const std::string& input, int reps){
+    using Eager = pegtl::memory_input<pegtl::tracking_mode::eager>;
+    using Lazy = pegtl::memory_input<pegtl::tracking_mode::lazy>;
+    double oldBps = throughput<OldRule, Eager>(input, reps);
+    double scalarBps = throughput<grammar::scanned<Scalar, false>, Lazy>(input, reps);
+    double newBps = throughput<NewRule, Lazy>(input, reps);
+    std::printf("%-22s old rule %8.1f MB/s   scalar scan %8.1f MB/s   %s scan %8.1f MB/s   x%.2f\n",
+        label, oldBps / 1e6, scalarBps / 1e6, STDLParser::scan::backendName(), newBps / 1e6, newBps / oldBps);
+}
+
+}
+
+int main(){
+    namespace scan = STDLParser::scan;
+
+    std::string blank = commentHeavyBlank(20000);
+    std::string body = stringHeavyBody(20000);
+
+    report<grammar::reference::opt_ws, scan::scalar::skipBlank, grammar::opt_ws>(
+        "whitespace + comments", blank, 10);
+    report<grammar::reference::string_content, scan::scalar::skipStringContent, grammar::string_content>(
+        "string content", body, 10);
+    return 0;
+}
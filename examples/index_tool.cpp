@@ -0,0 +1,37 @@
+#include "stdl.hpp"
+#include <cstdlib>
+#include <iostream>
+
+// Usage:
+//   STDL_index <scene.stdl>          build <scene.stdl>.idx
+//   STDL_index <scene.stdl> <id>     load and print the node with global ID <id>
+int main(int argc, char** argv){
+    if(argc < 2){
+        std::cerr << "usage: " << argv[0] << " <scene.stdl> [globalID]\n";
+        return 1;
+    }
+    std::string path = argv[1];
+
+    if(argc == 2){
+        STDL::SceneIndex index;
+        if(!STDL::BuildIndex(path, index) || !STDL::SaveIndex(index, STDL::IndexPath(path))){
+            std::cerr << "Failed to index " << path << "\n";
+            return 1;
+        }
+        std::cout << "Indexed " << index.nodes.size() << " nodes and "
+                  << index.prefabs.size() << " prefabs into " << STDL::IndexPath(path) << "\n";
+        return 0;
+    }
+
+    int id = std::atoi(argv[2]);
+    NodePtr node = STDL::LoadNode(path, id);
+    if(!node){
+        std::cerr << "Node @" << id << " not found\n";
+        return 1;
+    }
+
+    auto scene = std::make_shared<Scene>();
+    scene->addNode(node);
+    std::cout << STDL::ToString(scene);
+    return 0;
+}
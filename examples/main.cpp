@@ -46,6 +46,13 @@ int main(){
     if(tree->get("height",height))
         std::cout<<"Tree Height: "<<height<<"\n";
 
+    NodePtr birch = forest->getChild("Birch1");
+    if(birch && birch->isInstance()){
+        std::cout << "Birch1 is an instance of " << birch->prefab->name << "\n";
+        if(birch->findChild("Branch"))
+            std::cout << "Birch1 inherits its Branch child\n";
+    }
+
     auto goblin = scene->getNodeByGlobalID(777);
 
     std::vector<std::shared_ptr<ValueNode>> loot;
@@ -1,5 +1,7 @@
 #pragma once
 #include "scene.hpp"
+#include "columns.hpp"
+#include "index.hpp"
 #include <memory>
 #include <string>
 
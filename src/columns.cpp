@@ -0,0 +1,85 @@
+#include "columns.hpp"
+#include <algorithm>
+#include <thread>
+#include <utility>
+
+namespace STDL {
+
+namespace {
+struct RowSet {
+    std::vector<NodePtr> rows;
+    std::vector<NodePtr> owners;
+};
+
+// owner is the scene-tree instance once the walk has entered a prefab.
+void collectRows(const NodePtr& node, const NodePtr& owner, const ColumnQuery& query, RowSet& out){
+    if(node->type == query.type){
+        out.rows.push_back(node);
+        out.owners.push_back(owner);
+    }
+    for(auto& c : node->children){
+        collectRows(c, owner, query, out);
+    }
+    if(query.skipInherited) return;
+    const NodePtr& inheritedOwner = owner ? owner : node;
+    for(const Node* p = node->prefab.get(); p; p = p->prefab.get()){
+        for(auto& c : p->children){
+            collectRows(c, inheritedOwner, query, out);
+        }
+    }
+}
+
+// Splits [0, count) into at most `threads` contiguous ranges and runs
+// work(chunk, begin, end) for each, one thread per range.
+template<typename Work>
+void forEachRange(size_t count, unsigned threads, Work work){
+    size_t chunks = std::min<size_t>(threads, count);
+    if(chunks <= 1){
+        work(size_t(0), size_t(0), count);
+        return;
+    }
+    std::vector<std::thread> workers;
+    workers.reserve(chunks);
+    size_t step = (count + chunks - 1) / chunks;
+    for(size_t chunk = 0, begin = 0; begin < count; ++chunk, begin += step){
+        size_t end = std::min(count, begin + step);
+        workers.emplace_back([&work, chunk, begin, end]{ work(chunk, begin, end); });
+    }
+    for(auto& w : workers) w.join();
+}
+}
+
+void ColumnQuery::run(Scene& scene, unsigned threads){
+    if(threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+
+    RowSet all;
+    if(threads == 1){
+        for(auto& n : scene.nodes){
+            collectRows(n, nullptr, *this, all);
+        }
+    } else {
+        std::vector<RowSet> parts(threads);
+        forEachRange(scene.nodes.size(), threads, [&](size_t chunk, size_t begin, size_t end){
+            for(size_t i = begin; i < end; ++i){
+                collectRows(scene.nodes[i], nullptr, *this, parts[chunk]);
+            }
+        });
+        for(auto& part : parts){
+            all.rows.insert(all.rows.end(), part.rows.begin(), part.rows.end());
+            all.owners.insert(all.owners.end(), part.owners.begin(), part.owners.end());
+        }
+    }
+    matched = std::move(all.rows);
+    matchedOwners = std::move(all.owners);
+
+    for(auto& slot : slots){
+        slot->resize(matched.size());
+    }
+    forEachRange(matched.size(), threads, [&](size_t, size_t begin, size_t end){
+        for(auto& slot : slots){
+            slot->fill(matched, begin, end);
+        }
+    });
+}
+
+}
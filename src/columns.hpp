@@ -0,0 +1,171 @@
+#pragma once
+#include "scene.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace STDL {
+
+namespace detail {
+// Element type a Column<T> stores. bool columns use one byte per row, like
+// `valid`: std::vector<bool> packs bits, which can't be filled in place or
+// from several threads.
+template<typename T>
+struct ColumnStorage {
+    using type = T;
+};
+
+template<>
+struct ColumnStorage<bool> {
+    using type = uint8_t;
+};
+}
+
+// Values of one property across every matched node, in row order.
+// valid[i] is 0 when row i has no such property or its value doesn't
+// convert to T; values[i] is then left as T{}.
+template<typename T>
+struct Column {
+    std::string key;
+    std::vector<typename detail::ColumnStorage<T>::type> values;
+    std::vector<uint8_t> valid;
+};
+
+namespace detail {
+
+// Converts a stored value to a column element. double columns also accept
+// ints; std::array<E, N> columns take lists of exactly N convertible
+// elements.
+template<typename T>
+struct ColumnValue {
+    static bool convert(const Value& v, T& out){
+        if(!std::holds_alternative<T>(v)) return false;
+        out = std::get<T>(v);
+        return true;
+    }
+};
+
+template<>
+struct ColumnValue<double> {
+    static bool convert(const Value& v, double& out){
+        if(std::holds_alternative<double>(v)){
+            out = std::get<double>(v);
+            return true;
+        }
+        if(std::holds_alternative<int>(v)){
+            out = std::get<int>(v);
+            return true;
+        }
+        return false;
+    }
+};
+
+template<typename E, size_t N>
+struct ColumnValue<std::array<E, N>> {
+    static bool convert(const Value& v, std::array<E, N>& out){
+        if(!std::holds_alternative<std::vector<std::shared_ptr<ValueNode>>>(v)) return false;
+        auto& list = std::get<std::vector<std::shared_ptr<ValueNode>>>(v);
+        if(list.size() != N) return false;
+        for(size_t i = 0; i < N; ++i){
+            if(!ColumnValue<E>::convert(list[i]->value, out[i])) return false;
+        }
+        return true;
+    }
+};
+
+// The parser stores `key = value` as a one-element list, so scalar columns
+// look through that wrapper.
+template<typename T>
+bool convertProperty(const Value& v, T& out){
+    if(ColumnValue<T>::convert(v, out)) return true;
+    if(std::holds_alternative<std::vector<std::shared_ptr<ValueNode>>>(v)){
+        auto& list = std::get<std::vector<std::shared_ptr<ValueNode>>>(v);
+        if(list.size() == 1) return ColumnValue<T>::convert(list[0]->value, out);
+    }
+    return false;
+}
+
+struct ColumnSlot {
+    virtual ~ColumnSlot() = default;
+    virtual void resize(size_t rows) = 0;
+    virtual void fill(const std::vector<NodePtr>& rows, size_t begin, size_t end) = 0;
+};
+
+template<typename T>
+struct TypedColumnSlot : ColumnSlot {
+    Column<T> column;
+
+    void resize(size_t rows) override {
+        column.values.assign(rows, typename ColumnStorage<T>::type{});
+        column.valid.assign(rows, 0);
+    }
+
+    void fill(const std::vector<NodePtr>& rows, size_t begin, size_t end) override {
+        for(size_t i = begin; i < end; ++i){
+            const Value* v = rows[i]->findProperty(column.key);
+            T value{};
+            if(v && convertProperty(*v, value)){
+                column.values[i] = value;
+                column.valid[i] = 1;
+            }
+        }
+    }
+};
+
+}
+
+// Extracts properties of every node of one type into contiguous columns:
+//
+//     STDL::ColumnQuery query("enemy");
+//     auto& health = query.add<double>("health");
+//     auto& position = query.add<std::array<double, 3>>("position");
+//     query.run(*scene);
+//
+// Rows follow depth-first scene order, including children inherited from a
+// prefab.
+struct ColumnQuery {
+    std::string type;
+
+    // A child an instance inherits from its prefab is one shared Node, so it
+    // appears as the same row pointer under every instance; owners() tells
+    // those rows apart. Set this to visit only each node's own children.
+    bool skipInherited = false;
+
+    explicit ColumnQuery(std::string nodeType) : type(std::move(nodeType)) {}
+
+    // The returned column is owned by the query and filled by run().
+    template<typename T>
+    const Column<T>& add(const std::string& key){
+        auto slot = std::make_unique<detail::TypedColumnSlot<T>>();
+        slot->column.key = key;
+        const Column<T>& column = slot->column;
+        slots.push_back(std::move(slot));
+        return column;
+    }
+
+    // Collects matching nodes and fills every column. With threads > 1 the
+    // top-level nodes are split between workers; 0 uses one thread per core.
+    void run(Scene& scene, unsigned threads = 1);
+
+    const std::vector<NodePtr>& rows() const {
+        return matched;
+    }
+
+    // Parallel to rows(): for a row reached through a prefab, the instance in
+    // the scene tree it was inherited by (the outermost one when prefabs
+    // nest); nullptr for rows that are ordinary scene nodes.
+    const std::vector<NodePtr>& owners() const {
+        return matchedOwners;
+    }
+
+private:
+    std::vector<std::unique_ptr<detail::ColumnSlot>> slots;
+    std::vector<NodePtr> matched;
+    std::vector<NodePtr> matchedOwners;
+};
+
+}
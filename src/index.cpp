@@ -0,0 +1,199 @@
+#include "index.hpp"
+#include "parser.hpp"
+#include "stdl.hpp"
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace STDL {
+
+namespace {
+// 64-bit FNV-1a over the raw file bytes.
+constexpr uint64_t kHashSeed = 14695981039346656037ull;
+
+uint64_t hashBytes(const char* data, size_t size, uint64_t hash){
+    for(size_t i = 0; i < size; ++i){
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+bool hashFile(const std::string& path, uint64_t& size, uint64_t& hash){
+    std::ifstream file(path, std::ios::binary);
+    if(!file) return false;
+    hash = kHashSeed;
+    size = 0;
+    std::vector<char> buf(1 << 16);
+    while(file){
+        file.read(buf.data(), static_cast<std::streamsize>(buf.size()));
+        size_t got = static_cast<size_t>(file.gcount());
+        hash = hashBytes(buf.data(), got, hash);
+        size += got;
+    }
+    return true;
+}
+
+// Reads an entry's block and checks it against the hash taken at indexing.
+bool readBlock(std::ifstream& file, const IndexEntry& entry, std::string& out){
+    file.clear();
+    out.resize(entry.length);
+    file.seekg(static_cast<std::streamoff>(entry.offset));
+    file.read(&out[0], static_cast<std::streamsize>(entry.length));
+    if(static_cast<size_t>(file.gcount()) != entry.length) return false;
+    return hashBytes(out.data(), out.size(), kHashSeed) == entry.hash;
+}
+
+void writeEntry(std::ostream& os, const char* kind, const IndexEntry& e, bool withID){
+    os << kind;
+    if(withID) os << " " << e.globalID;
+    os << " " << e.offset << " " << e.length << " " << std::hex << e.hash << std::dec
+       << " " << e.type << " " << e.name << "\n";
+}
+
+void sortByID(std::vector<IndexEntry>& entries){
+    std::stable_sort(entries.begin(), entries.end(),
+        [](const IndexEntry& a, const IndexEntry& b){ return a.globalID < b.globalID; });
+}
+}
+
+std::string IndexPath(const std::string& path){
+    return path + ".idx";
+}
+
+bool BuildIndex(const std::string& path, SceneIndex& out){
+    // Binary mode so offsets are byte offsets on every platform.
+    std::ifstream file(path, std::ios::binary);
+    if(!file) return false;
+    std::stringstream ss;
+    ss << file.rdbuf();
+    std::string content = ss.str();
+
+    Scene scene;
+    std::vector<STDLParser::NodeSpan> spans;
+    if(!STDLParser::ParseSTDL(content, scene, &spans)){
+        std::cerr << "Failed to parse STDL content\n";
+        return false;
+    }
+
+    out = SceneIndex();
+    out.fileSize = content.size();
+    out.fileHash = hashBytes(content.data(), content.size(), kHashSeed);
+
+    for(auto& span : spans){
+        if(!span.prefab && !span.node->globalID) continue;
+        IndexEntry e;
+        e.type = span.node->type;
+        e.name = span.node->name;
+        e.offset = span.offset;
+        e.length = span.length;
+        e.hash = hashBytes(content.data() + span.offset, span.length, kHashSeed);
+        if(span.prefab){
+            out.prefabs.push_back(e);
+        } else {
+            e.globalID = *span.node->globalID;
+            out.nodes.push_back(e);
+        }
+    }
+    sortByID(out.nodes);
+    return true;
+}
+
+bool SaveIndex(const SceneIndex& index, const std::string& indexPath){
+    std::ofstream file(indexPath);
+    if(!file) return false;
+    file << "stdl-index v1\n";
+    file << "size " << index.fileSize << "\n";
+    file << "hash " << std::hex << index.fileHash << std::dec << "\n";
+    for(auto& e : index.prefabs) writeEntry(file, "prefab", e, false);
+    for(auto& e : index.nodes) writeEntry(file, "node", e, true);
+    return static_cast<bool>(file);
+}
+
+bool LoadIndex(const std::string& indexPath, SceneIndex& out){
+    std::ifstream file(indexPath);
+    if(!file) return false;
+
+    std::string line;
+    if(!std::getline(file, line) || line != "stdl-index v1") return false;
+
+    out = SceneIndex();
+    bool hasSize = false, hasHash = false;
+    while(std::getline(file, line)){
+        std::istringstream ls(line);
+        std::string kind;
+        ls >> kind;
+        if(kind == "size"){
+            if(!(ls >> out.fileSize)) return false;
+            hasSize = true;
+        } else if(kind == "hash"){
+            if(!(ls >> std::hex >> out.fileHash)) return false;
+            hasHash = true;
+        } else if(kind == "prefab" || kind == "node"){
+            IndexEntry e;
+            if(kind == "node" && !(ls >> e.globalID)) return false;
+            if(!(ls >> e.offset >> e.length >> std::hex >> e.hash >> std::dec)) return false;
+            ls >> e.type >> e.name;
+            (kind == "node" ? out.nodes : out.prefabs).push_back(e);
+        }
+    }
+    if(!hasSize || !hasHash) return false;
+    sortByID(out.nodes);
+    return true;
+}
+
+bool IndexIsCurrent(const std::string& path, const SceneIndex& index){
+    uint64_t size = 0, hash = 0;
+    if(!hashFile(path, size, hash)) return false;
+    return size == index.fileSize && hash == index.fileHash;
+}
+
+NodePtr LoadNode(const std::string& path, const SceneIndex& index, int globalID){
+    const IndexEntry* entry = index.find(globalID);
+    if(!entry) return nullptr;
+
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if(!file) return nullptr;
+    if(static_cast<uint64_t>(file.tellg()) != index.fileSize){
+        std::cerr << "Index for " << path << " is stale\n";
+        return nullptr;
+    }
+
+    // Prefabs are small and may be needed by the block or its children, so
+    // they are always prepended.
+    std::string content = "scene v1\n";
+    std::string block;
+    for(auto& p : index.prefabs){
+        if(!readBlock(file, p, block)){
+            std::cerr << "Index for " << path << " is stale\n";
+            return nullptr;
+        }
+        content += block;
+        content += "\n";
+    }
+    if(!readBlock(file, *entry, block)){
+        std::cerr << "Index for " << path << " is stale\n";
+        return nullptr;
+    }
+    content += block;
+
+    ScenePtr scene = LoadString(content);
+    if(!scene) return nullptr;
+    return scene->getNodeByGlobalID(globalID);
+}
+
+NodePtr LoadNode(const std::string& path, int globalID){
+    SceneIndex index;
+    if(!LoadIndex(IndexPath(path), index)){
+        std::cerr << "No index for " << path << "\n";
+        return nullptr;
+    }
+    return LoadNode(path, index, globalID);
+}
+
+NodePtr ResolveIndexedRef(const std::string& path, const SceneIndex& index, const Ref& ref){
+    if(!ref.globalID) return nullptr;
+    return LoadNode(path, index, *ref.globalID);
+}
+
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include "scene.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace STDL {
+
+// Where one block lives in a .stdl file: from its `node`/`prefab` keyword
+// through the closing brace.
+struct IndexEntry {
+    int globalID = 0;
+    std::string type;
+    std::string name;
+    size_t offset = 0;
+    size_t length = 0;
+    // FNV-1a of the block's bytes, checked whenever the block is read.
+    uint64_t hash = 0;
+};
+
+// Offsets of every node with a global ID (nested ones included) plus every
+// prefab, so single nodes can be loaded without parsing the whole file.
+// Saved next to the scene as "<path>.idx".
+struct SceneIndex {
+    uint64_t fileSize = 0;
+    uint64_t fileHash = 0;
+    // Sorted by globalID; BuildIndex and LoadIndex keep it that way.
+    std::vector<IndexEntry> nodes;
+    std::vector<IndexEntry> prefabs;
+
+    const IndexEntry* find(int globalID) const {
+        auto it = std::lower_bound(nodes.begin(), nodes.end(), globalID,
+            [](const IndexEntry& e, int id){ return e.globalID < id; });
+        if(it != nodes.end() && it->globalID == globalID) return &*it;
+        return nullptr;
+    }
+};
+
+std::string IndexPath(const std::string& path);
+
+// Parses the whole file once and records its block offsets.
+bool BuildIndex(const std::string& path, SceneIndex& out);
+
+bool SaveIndex(const SceneIndex& index, const std::string& indexPath);
+
+bool LoadIndex(const std::string& indexPath, SceneIndex& out);
+
+// Re-hashes the whole file and compares it with the index. LoadNode only
+// verifies the blocks it reads.
+bool IndexIsCurrent(const std::string& path, const SceneIndex& index);
+
+// Reads and parses just the block of the node with the given global ID
+// (plus the file's prefabs, if any). References to nodes outside that block
+// stay unresolved; pass them to ResolveIndexedRef. Returns nullptr if the
+// ID isn't indexed, or if the file size or the hash of any block read no
+// longer matches the index.
+NodePtr LoadNode(const std::string& path, const SceneIndex& index, int globalID);
+
+// As above, but reads the index from IndexPath(path) on every call. For
+// repeated lookups, LoadIndex once and use the overload above.
+NodePtr LoadNode(const std::string& path, int globalID);
+
+// Loads the target of a global reference through the index. Local
+// references resolve within the loaded block via Node::resolveRef.
+NodePtr ResolveIndexedRef(const std::string& path, const SceneIndex& index, const Ref& ref);
+
+}
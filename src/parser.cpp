@@ -29,6 +29,11 @@ static bool hasPath(
 struct ParserState {
     Scene* scene = nullptr;
     std::vector<NodePtr> nodeStack;
+    bool inPrefab = false;
+
+    const char* inputBegin = nullptr;
+    std::vector<NodeSpan>* spans = nullptr;
+    NodePtr lastClosed;
 
     bool inList = false;
     std::vector<std::shared_ptr<ValueNode>> currentList;
@@ -279,36 +284,63 @@ template<> struct Action<grammar::property>{
     }
 };
 
-template<> struct Action<grammar::node_header> {
-    template<typename Input>
-    static void apply(const Input& in, ParserState& state){
-        std::string text = in.string();
-        text.erase(0, text.find_first_not_of(" \t\r\n"));
-        text.erase(text.find_last_not_of(" \t\r\n") + 1);
-
-        std::istringstream ss(text);
-        std::string tmp, type, name;
-        ss >> tmp >> type >> name;
-
-        NodePtr node = std::make_shared<Node>();
-        node->type = type;
-        node->name = name;
-
-        std::string token;
-        while(ss >> token){
-            if(token[0]=='@'){
-                node->globalID = std::stoi(token.substr(1));
-                if (node->globalID) {
-                    state.globalIDMap[*node->globalID] = node.get();
-                }
+// Shared by node and prefab headers: `<keyword> <type> <name> [@id] [#id] [from <prefab>]`.
+template<typename Input>
+NodePtr makeNodeFromHeader(const Input& in, ParserState& state){
+    std::string text = in.string();
+    text.erase(0, text.find_first_not_of(" \t\r\n"));
+    text.erase(text.find_last_not_of(" \t\r\n") + 1);
+
+    std::istringstream ss(text);
+    std::string tmp, type, name;
+    ss >> tmp >> type >> name;
+
+    NodePtr node = std::make_shared<Node>();
+    node->type = type;
+    node->name = name;
+
+    std::string token;
+    while(ss >> token){
+        if(token.compare(0, 2, "//") == 0){
+            break;
+        }
+        else if(token[0]=='@'){
+            if(state.inPrefab){
+                throw pegtl::parse_error(
+                    "Global IDs are not allowed inside a prefab",
+                    in
+                );
             }
-            else if(token[0]=='#'){
-                node->localID = std::stoi(token.substr(1));
-                if (node->localID) {
-                    state.localIDMap[*node->localID] = node.get();
-                }
+            node->globalID = std::stoi(token.substr(1));
+            if (node->globalID) {
+                state.globalIDMap[*node->globalID] = node.get();
+            }
+        }
+        else if(token[0]=='#'){
+            node->localID = std::stoi(token.substr(1));
+            if (node->localID) {
+                state.localIDMap[*node->localID] = node.get();
+            }
+        }
+        else if(token == "from"){
+            std::string prefabName;
+            ss >> prefabName;
+            node->prefab = state.scene->getPrefab(prefabName);
+            if(!node->prefab){
+                throw pegtl::parse_error(
+                    "Unknown prefab '" + prefabName + "'",
+                    in
+                );
             }
         }
+    }
+    return node;
+}
+
+template<> struct Action<grammar::node_header> {
+    template<typename Input>
+    static void apply(const Input& in, ParserState& state){
+        NodePtr node = makeNodeFromHeader(in, state);
 
         if(state.nodeStack.empty()){
             state.scene->addNode(node);
@@ -320,19 +352,67 @@ template<> struct Action<grammar::node_header> {
     }
 };
 
+template<> struct Action<grammar::prefab_header> {
+    template<typename Input>
+    static void apply(const Input& in, ParserState& state){
+        state.inPrefab = true;
+        NodePtr prefab = makeNodeFromHeader(in, state);
+
+        if(state.scene->getPrefab(prefab->name)){
+            throw pegtl::parse_error(
+                "Duplicate prefab '" + prefab->name + "'",
+                in
+            );
+        }
+        state.scene->addPrefab(prefab);
+        state.nodeStack.push_back(prefab);
+    }
+};
+
+template<typename Input>
+void recordSpan(const Input& in, ParserState& state, bool prefab){
+    if(!state.spans || !state.lastClosed) return;
+    NodeSpan span;
+    span.node = state.lastClosed;
+    span.offset = static_cast<size_t>(in.begin() - state.inputBegin);
+    span.length = in.size();
+    span.prefab = prefab;
+    state.spans->push_back(span);
+}
+
+template<> struct Action<grammar::node> {
+    template<typename Input>
+    static void apply(const Input& in, ParserState& state){
+        recordSpan(in, state, false);
+    }
+};
+
+template<> struct Action<grammar::prefab> {
+    template<typename Input>
+    static void apply(const Input& in, ParserState& state){
+        state.inPrefab = false;
+        recordSpan(in, state, true);
+    }
+};
+
 template<> struct Action<pegtl::one<'}'>>{
     template<typename Input>
     static void apply(const Input&, ParserState& state){
         if(!state.nodeStack.empty()){
+            state.lastClosed = state.nodeStack.back();
             state.nodeStack.pop_back();
         }
     }
 };
 
-bool ParseSTDL(const std::string& input, Scene& scene){
+bool ParseSTDL(const std::string& input, Scene& scene, std::vector<NodeSpan>* spans){
     ParserState state;
     state.scene = &scene;
-    pegtl::memory_input<> in(input,"STDL");
+    state.inputBegin = input.data();
+    state.spans = spans;
+    // Lazy tracking keeps bump() a pointer increment; line/column are only
+    // computed when a parse_error is actually reported.
+    pegtl::memory_input<pegtl::tracking_mode::lazy> in(input,"STDL");
     try{
         bool result = pegtl::parse<grammar::scene,Action>(in,state);
         return result;
@@ -1,24 +1,53 @@
 #pragma once
 #include "scene.hpp"
+#include "scan.hpp"
 #include <tao/pegtl.hpp>
+#include <cstddef>
 #include <string>
+#include <vector>
+
+// The grammar's custom rules and the parser's lazy input rely on the
+// PEGTL 3 input/rule interfaces.
+#if !defined(TAO_PEGTL_VERSION_MAJOR) || TAO_PEGTL_VERSION_MAJOR != 3
+#error "STDL requires PEGTL 3.x (external/PEGTL)"
+#endif
 
 namespace STDLParser {
 namespace pegtl = TAO_PEGTL_NAMESPACE;
 
 namespace grammar {
-struct comment : pegtl::seq<pegtl::string<'/','/'>, pegtl::until<pegtl::eolf>> {};
+// Custom rule that hands a whole run of input to one of the block scanners
+// in scan.hpp instead of matching it character by character. When Required
+// is set the rule fails unless at least one byte was consumed, so it can be
+// used inside pegtl::star.
+template<const char* (*Skip)(const char*, const char*), bool Required>
+struct scanned {
+    using rule_t = scanned;
+    using subs_t = pegtl::type_list<>;
+
+    template<typename ParseInput>
+    static bool match(ParseInput& in){
+        const char* from = in.current();
+        const char* to = Skip(from, in.end());
+        if(Required && to == from) return false;
+        in.bump(static_cast<std::size_t>(to - from));
+        return true;
+    }
+};
+
+// Whitespace and `//` comments (a comment runs to the end of its line).
 struct ws : pegtl::plus<pegtl::space> {};
-struct opt_ws : pegtl::star<pegtl::sor<pegtl::space, comment>> {};
-struct ws_or_comment : pegtl::sor<ws, comment> {};
-struct opt_ws_or_comment : pegtl::star<pegtl::sor<pegtl::space, comment>> {};
+struct opt_ws : scanned<scan::skipBlank, false> {};
+struct ws_or_comment : scanned<scan::skipBlank, true> {};
+struct opt_ws_or_comment : scanned<scan::skipBlank, false> {};
 
 struct sign : pegtl::opt<pegtl::one<'-', '+'>> {};
 struct integer : pegtl::seq<sign, pegtl::plus<pegtl::digit>> {};
 struct floating : pegtl::seq<sign, pegtl::plus<pegtl::digit>, pegtl::one<'.'>, pegtl::plus<pegtl::digit>> {};
 struct boolean : pegtl::sor<pegtl::string<'t','r','u','e'>, pegtl::string<'f','a','l','s','e'>> {};
 struct escaped_char : pegtl::seq<pegtl::one<'\\'>, pegtl::one<'"', '\\', 'n', 't', 'r'>> {};
-struct string_content : pegtl::star<pegtl::sor<escaped_char, pegtl::not_one<'"', '\\'>>> {};
+// Matches the same input as reference::string_content.
+struct string_content : scanned<scan::skipStringContent, false> {};
 struct quoted_string : pegtl::seq<pegtl::one<'"'>, string_content, pegtl::one<'"'>> {};
 struct local_ref : pegtl::seq<pegtl::one<'<'>, pegtl::opt<pegtl::plus<pegtl::not_one<'#', '>', ',', '\n', '\r'>>>, pegtl::one<'#'>, pegtl::plus<pegtl::digit>, pegtl::one<'>'>> {};
 struct global_ref : pegtl::seq<pegtl::one<'<'>, pegtl::plus<pegtl::not_one<':', '>', ',', '\n', '\r'>>, pegtl::one<':'>, pegtl::plus<pegtl::not_one<'@', '>', ',', '\n', '\r'>>, pegtl::one<'@'>, pegtl::plus<pegtl::digit>, pegtl::one<'>'>> {};
@@ -35,8 +64,31 @@ struct node;
 struct nodes : pegtl::star<pegtl::sor<node, property, ws_or_comment>> {};
 struct node_header : pegtl::seq<pegtl::string<'n','o','d','e'>, ws, pegtl::plus<pegtl::not_one<'{', '\n', '\r'>>, opt_ws_or_comment> {};
 struct node : pegtl::seq<node_header, pegtl::one<'{'>, opt_ws_or_comment, nodes, opt_ws_or_comment, pegtl::one<'}'>> {};
-struct scene : pegtl::seq<pegtl::string<'s','c','e','n','e',' ','v','1'>, opt_ws_or_comment, pegtl::star<pegtl::sor<node, ws_or_comment>>, opt_ws_or_comment, pegtl::eof> {};
+struct prefab_header : pegtl::seq<pegtl::string<'p','r','e','f','a','b'>, ws, pegtl::plus<pegtl::not_one<'{', '\n', '\r'>>, opt_ws_or_comment> {};
+struct prefab : pegtl::seq<prefab_header, pegtl::one<'{'>, opt_ws_or_comment, nodes, opt_ws_or_comment, pegtl::one<'}'>> {};
+struct scene : pegtl::seq<pegtl::string<'s','c','e','n','e',' ','v','1'>, opt_ws_or_comment, pegtl::star<pegtl::sor<prefab, node, ws_or_comment>>, opt_ws_or_comment, pegtl::eof> {};
+
+// The character-at-a-time rules the scanned ones replaced. Not used by the
+// parser; tests/scan_rules_test.cpp checks both forms consume the same
+// input and STDL_bench_scan measures them against each other.
+namespace reference {
+struct comment : pegtl::seq<pegtl::string<'/','/'>, pegtl::until<pegtl::eolf>> {};
+struct opt_ws : pegtl::star<pegtl::sor<pegtl::space, comment>> {};
+struct ws_or_comment : pegtl::sor<pegtl::plus<pegtl::space>, comment> {};
+struct string_content : pegtl::star<pegtl::sor<escaped_char, pegtl::not_one<'"', '\\'>>> {};
+}
 }
 
-bool ParseSTDL(const std::string& input, Scene& scene);
+// Byte range of a `node` or `prefab` block within the parsed input,
+// from its keyword up to and including the closing brace.
+struct NodeSpan {
+    NodePtr node;
+    size_t offset = 0;
+    size_t length = 0;
+    bool prefab = false;
+};
+
+// When spans is given, every block is recorded there as it closes, so a
+// nested node precedes its parent.
+bool ParseSTDL(const std::string& input, Scene& scene, std::vector<NodeSpan>* spans = nullptr);
 }
\ No newline at end of file
@@ -0,0 +1,214 @@
+#include "scan.hpp"
+
+#if defined(__AVX2__)
+    #define STDL_SCAN_AVX2 1
+    #include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define STDL_SCAN_SSE2 1
+    #include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+    #include <intrin.h>
+#endif
+
+namespace STDLParser {
+namespace scan {
+
+namespace {
+
+template<const char* (*SkipSpace)(const char*, const char*),
+         const char* (*FindLineEnd)(const char*, const char*)>
+const char* skipBlankWith(const char* p, const char* end){
+    for(;;){
+        p = SkipSpace(p, end);
+        if(end - p < 2 || p[0] != '/' || p[1] != '/') return p;
+        p = FindLineEnd(p + 2, end);
+        if(p != end) ++p;
+    }
+}
+
+template<const char* (*FindQuoteOrEscape)(const char*, const char*)>
+const char* skipStringContentWith(const char* p, const char* end){
+    for(;;){
+        p = FindQuoteOrEscape(p, end);
+        if(p == end || *p == '"') return p;
+        if(end - p < 2) return p;
+        switch(p[1]){
+            case '"': case '\\': case 'n': case 't': case 'r':
+                p += 2;
+                break;
+            default:
+                return p;
+        }
+    }
+}
+
+#if defined(STDL_SCAN_AVX2) || defined(STDL_SCAN_SSE2)
+inline unsigned lowestBit(unsigned mask){
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long idx;
+    _BitScanForward(&idx, mask);
+    return static_cast<unsigned>(idx);
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+#endif
+
+#if defined(STDL_SCAN_AVX2)
+constexpr std::ptrdiff_t kBlock = 32;
+
+inline __m256i load(const char* p){
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+
+inline unsigned toMask(__m256i v){
+    return static_cast<unsigned>(_mm256_movemask_epi8(v));
+}
+
+inline __m256i spaceBytes(__m256i v){
+    __m256i sp = _mm256_cmpeq_epi8(v, _mm256_set1_epi8(' '));
+    __m256i t = _mm256_sub_epi8(v, _mm256_set1_epi8('\t'));
+    __m256i ctl = _mm256_cmpeq_epi8(_mm256_min_epu8(t, _mm256_set1_epi8(4)), t);
+    return _mm256_or_si256(sp, ctl);
+}
+
+inline __m256i byteEq(__m256i v, char c){
+    return _mm256_cmpeq_epi8(v, _mm256_set1_epi8(c));
+}
+
+inline __m256i either(__m256i a, __m256i b){
+    return _mm256_or_si256(a, b);
+}
+
+constexpr unsigned kFullMask = 0xFFFFFFFFu;
+#elif defined(STDL_SCAN_SSE2)
+constexpr std::ptrdiff_t kBlock = 16;
+
+inline __m128i load(const char* p){
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+}
+
+inline unsigned toMask(__m128i v){
+    return static_cast<unsigned>(_mm_movemask_epi8(v));
+}
+
+inline __m128i spaceBytes(__m128i v){
+    __m128i sp = _mm_cmpeq_epi8(v, _mm_set1_epi8(' '));
+    __m128i t = _mm_sub_epi8(v, _mm_set1_epi8('\t'));
+    __m128i ctl = _mm_cmpeq_epi8(_mm_min_epu8(t, _mm_set1_epi8(4)), t);
+    return _mm_or_si128(sp, ctl);
+}
+
+inline __m128i byteEq(__m128i v, char c){
+    return _mm_cmpeq_epi8(v, _mm_set1_epi8(c));
+}
+
+inline __m128i either(__m128i a, __m128i b){
+    return _mm_or_si128(a, b);
+}
+
+constexpr unsigned kFullMask = 0xFFFFu;
+#endif
+
+}
+
+namespace scalar {
+
+const char* skipSpace(const char* p, const char* end){
+    while(p != end && isSpace(*p)) ++p;
+    return p;
+}
+
+const char* findLineEnd(const char* p, const char* end){
+    while(p != end && *p != '\n') ++p;
+    return p;
+}
+
+const char* findQuoteOrEscape(const char* p, const char* end){
+    while(p != end && *p != '"' && *p != '\\') ++p;
+    return p;
+}
+
+const char* skipBlank(const char* p, const char* end){
+    return skipBlankWith<scalar::skipSpace, scalar::findLineEnd>(p, end);
+}
+
+const char* skipStringContent(const char* p, const char* end){
+    return skipStringContentWith<scalar::findQuoteOrEscape>(p, end);
+}
+
+}
+
+#if defined(STDL_SCAN_AVX2) || defined(STDL_SCAN_SSE2)
+
+const char* skipSpace(const char* p, const char* end){
+    // Indentation is usually a handful of bytes; don't pay for a block load
+    // when the very first byte already ends the run.
+    if(p == end || !isSpace(*p)) return p;
+    while(end - p >= kBlock){
+        unsigned other = ~toMask(spaceBytes(load(p))) & kFullMask;
+        if(other) return p + lowestBit(other);
+        p += kBlock;
+    }
+    return scalar::skipSpace(p, end);
+}
+
+const char* findLineEnd(const char* p, const char* end){
+    while(end - p >= kBlock){
+        unsigned hit = toMask(byteEq(load(p), '\n'));
+        if(hit) return p + lowestBit(hit);
+        p += kBlock;
+    }
+    return scalar::findLineEnd(p, end);
+}
+
+const char* findQuoteOrEscape(const char* p, const char* end){
+    while(end - p >= kBlock){
+        auto v = load(p);
+        unsigned hit = toMask(either(byteEq(v, '"'), byteEq(v, '\\')));
+        if(hit) return p + lowestBit(hit);
+        p += kBlock;
+    }
+    return scalar::findQuoteOrEscape(p, end);
+}
+
+const char* backendName(){
+#if defined(STDL_SCAN_AVX2)
+    return "avx2";
+#else
+    return "sse2";
+#endif
+}
+
+#else
+
+const char* skipSpace(const char* p, const char* end){
+    return scalar::skipSpace(p, end);
+}
+
+const char* findLineEnd(const char* p, const char* end){
+    return scalar::findLineEnd(p, end);
+}
+
+const char* findQuoteOrEscape(const char* p, const char* end){
+    return scalar::findQuoteOrEscape(p, end);
+}
+
+const char* backendName(){
+    return "scalar";
+}
+
+#endif
+
+const char* skipBlank(const char* p, const char* end){
+    return skipBlankWith<scan::skipSpace, scan::findLineEnd>(p, end);
+}
+
+const char* skipStringContent(const char* p, const char* end){
+    return skipStringContentWith<scan::findQuoteOrEscape>(p, end);
+}
+
+}
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <cstddef>
+
+// Block scanners used by the grammar to skip the bulk of a scene file
+// (indentation, comments, string bodies) 16 or 32 bytes at a time.
+// The SIMD width is picked at compile time: AVX2 if __AVX2__ is defined,
+// SSE2 on any x86-64 target, otherwise the scalar versions below.
+
+namespace STDLParser {
+namespace scan {
+
+// Whitespace as matched by pegtl::space: ' ', '\t', '\n', '\v', '\f', '\r'.
+inline bool isSpace(char c){
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+// First byte in [p, end) that is not whitespace, or end.
+const char* skipSpace(const char* p, const char* end);
+
+// First '\n' in [p, end), or end.
+const char* findLineEnd(const char* p, const char* end);
+
+// First '"' or '\\' in [p, end), or end.
+const char* findQuoteOrEscape(const char* p, const char* end);
+
+// Skips any mix of whitespace and `//` comments. A comment runs up to and
+// including its terminating '\n' (or to end of input).
+const char* skipBlank(const char* p, const char* end);
+
+// Skips the body of a quoted string up to the closing '"', stepping over
+// valid escape sequences. Stops at the closing quote, at an invalid escape,
+// or at end of input.
+const char* skipStringContent(const char* p, const char* end);
+
+// Byte-at-a-time reference implementations. Used for block tails and by
+// the scan benchmark as a baseline.
+namespace scalar {
+const char* skipSpace(const char* p, const char* end);
+const char* findLineEnd(const char* p, const char* end);
+const char* findQuoteOrEscape(const char* p, const char* end);
+const char* skipBlank(const char* p, const char* end);
+const char* skipStringContent(const char* p, const char* end);
+}
+
+// Name of the instruction set the non-scalar scanners were built for.
+const char* backendName();
+
+}
+}
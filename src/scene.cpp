@@ -81,12 +81,28 @@ std::string valueToString(const Value& val){
     return "";
 }
 
+Value deepCopy(const Value& val){
+    if(std::holds_alternative<std::vector<std::shared_ptr<ValueNode>>>(val)){
+        auto& vec = std::get<std::vector<std::shared_ptr<ValueNode>>>(val);
+        std::vector<std::shared_ptr<ValueNode>> copy;
+        copy.reserve(vec.size());
+        for(auto& item : vec){
+            auto node = std::make_shared<ValueNode>();
+            node->value = deepCopy(item->value);
+            copy.push_back(node);
+        }
+        return copy;
+    }
+    return val;
+}
+
 namespace {
-void serializeNode(const NodePtr& node, std::ostream& os, int indent=0){
+void serializeNode(const NodePtr& node, std::ostream& os, int indent=0, const char* keyword="node"){
     std::string ind(indent,' ');
-    os << ind << "node " << node->type << " " << node->name;
+    os << ind << keyword << " " << node->type << " " << node->name;
     if(node->globalID) os << " @" << *node->globalID;
     if(node->localID) os << " #" << *node->localID;
+    if(node->prefab) os << " from " << node->prefab->name;
     os << "\n" << ind << "{\n";
 
     for (auto it = node->properties.begin(); it != node->properties.end(); ++it) {
@@ -106,6 +122,9 @@ void serializeNode(const NodePtr& node, std::ostream& os, int indent=0){
 std::string ToString(const ScenePtr& scene){
     std::ostringstream os;
     os << "scene v1\n";
+    for(auto& p: scene->prefabs){
+        serializeNode(p, os, 0, "prefab");
+    }
     for(auto& n: scene->nodes){
         serializeNode(n, os, 0);
     }
@@ -113,7 +132,65 @@ std::string ToString(const ScenePtr& scene){
 }
 }
 
-NodePtr Node::resolveRef(const Ref& ref, Scene* scene)
+void Node::detach()
+{
+    if (!prefab) return;
+    NodePtr base = prefab;
+    prefab = nullptr;
+
+    for (const Node* p = base.get(); p; p = p->prefab.get()) {
+        for (auto& [key, value] : p->properties) {
+            if (!properties.count(key)) {
+                properties.emplace(key, STDL::deepCopy(value));
+            }
+        }
+        for (auto& c : p->children) {
+            children.push_back(c->clone());
+        }
+    }
+}
+
+NodePtr Node::clone() const
+{
+    NodePtr copy = std::make_shared<Node>(*this);
+    for (auto& [key, value] : copy->properties) {
+        value = STDL::deepCopy(value);
+    }
+    for (auto& c : copy->children) {
+        c = c->clone();
+    }
+    return copy;
+}
+
+bool Node::getList(const std::string& key, std::vector<std::shared_ptr<ValueNode>>& out)
+{
+    auto it = properties.find(key);
+    if (it == properties.end()) {
+        const Value* inherited = prefab ? prefab->findProperty(key) : nullptr;
+        if (!inherited || !std::holds_alternative<std::vector<std::shared_ptr<ValueNode>>>(*inherited)) {
+            return false;
+        }
+        it = properties.emplace(key, STDL::deepCopy(*inherited)).first;
+    }
+    if (!std::holds_alternative<std::vector<std::shared_ptr<ValueNode>>>(it->second)) {
+        return false;
+    }
+    out = std::get<std::vector<std::shared_ptr<ValueNode>>>(it->second);
+    return true;
+}
+
+std::shared_ptr<const Node> Node::resolveRef(const Ref& ref, Scene* scene) const
+{
+    if (ref.globalID && scene) {
+        return scene->getNodeByGlobalID(*ref.globalID);
+    }
+    if (ref.localID) {
+        return findChildByLocalID(*ref.localID);
+    }
+    return nullptr;
+}
+
+NodePtr Node::getRefTarget(const Ref& ref, Scene* scene)
 {
     if (ref.globalID && scene) {
         return scene->getNodeByGlobalID(*ref.globalID);
@@ -5,6 +5,7 @@
 #include <map>
 #include <memory>
 #include <optional>
+#include <type_traits>
 
 struct Scene;
 
@@ -40,36 +41,81 @@ struct Node {
     std::map<std::string, Value> properties;
     std::vector<NodePtr> children;
 
+    // Set when this node is an instance of a prefab. The prefab's properties
+    // and children are shared, not copied: `properties` only holds this
+    // instance's overrides and `children` only the children it adds. Lookups
+    // below fall through to the prefab. Accessors that hand out something
+    // mutable (getChild, getChildByLocalID, getList) copy inherited data into
+    // the instance first, so edits never reach the shared template.
+    NodePtr prefab;
+
+    bool isInstance() const {
+        return prefab != nullptr;
+    }
+
+    // Own value first, then the prefab chain. nullptr if the key is unset.
+    const Value* findProperty(const std::string& key) const {
+        auto it = properties.find(key);
+        if(it != properties.end()) return &it->second;
+        return prefab ? prefab->findProperty(key) : nullptr;
+    }
+
+    // Reaching an inherited child detaches this instance and returns its own
+    // copy. Use findChild to read without breaking the sharing.
     NodePtr getChild(const std::string& childName){
         for(auto& c: children)
             if(c->name == childName) return c;
-        return nullptr;
+        if(!prefab || !prefab->findChild(childName)) return nullptr;
+        detach();
+        return getChild(childName);
+    }
+
+    std::shared_ptr<const Node> findChild(const std::string& childName) const {
+        for(auto& c: children)
+            if(c->name == childName) return c;
+        return prefab ? prefab->findChild(childName) : nullptr;
     }
     
+    // Detaches whichever instance on the way down owns an inherited match,
+    // like getChild.
     NodePtr getChildByLocalID(int localID){
-        return findChildByLocalID(children, localID, type);
+        return resolveLocalID(this, localID, type);
+    }
+
+    std::shared_ptr<const Node> findChildByLocalID(int localID) const {
+        return searchLocalID(this, localID, type);
     }
     
     template<typename T>
     bool get(const std::string& key, T& out){
-        auto it = properties.find(key);
-        if(it != properties.end() && std::holds_alternative<T>(it->second)){
-            out = std::get<T>(it->second);
+        // Lists hand out their elements, so they take getList's copy-on-access.
+        if constexpr (std::is_same_v<T, std::vector<std::shared_ptr<ValueNode>>>) {
+            return getList(key, out);
+        }
+        const Value* v = findProperty(key);
+        if(v && std::holds_alternative<T>(*v)){
+            out = std::get<T>(*v);
             return true;
         }
         return false;
     }
     
     bool getRef(const std::string& key, Ref& out){
-        auto it = properties.find(key);
-        if(it != properties.end() && std::holds_alternative<Ref>(it->second)){
-            out = std::get<Ref>(it->second);
+        const Value* v = findProperty(key);
+        if(v && std::holds_alternative<Ref>(*v)){
+            out = std::get<Ref>(*v);
             return true;
         }
         return false;
     }
     
-    NodePtr resolveRef(const Ref& ref, Scene* scene);
+    // Read-only: local refs into inherited children resolve without
+    // detaching, so the instance keeps sharing its prefab.
+    std::shared_ptr<const Node> resolveRef(const Ref& ref, Scene* scene) const;
+
+    // Mutable counterpart; a local ref into inherited data detaches the
+    // instance, like getChildByLocalID.
+    NodePtr getRefTarget(const Ref& ref, Scene* scene);
     
     template<typename T>
     void set(const std::string& key, T val){
@@ -80,20 +126,16 @@ struct Node {
         children.push_back(child);
     }
 
-    bool getList(const std::string& key, std::vector<std::shared_ptr<ValueNode>>& out){
-        auto it = properties.find(key);
-        if(it != properties.end() && std::holds_alternative<std::vector<std::shared_ptr<ValueNode>>>(it->second)){
-            out = std::get<std::vector<std::shared_ptr<ValueNode>>>(it->second);
-            return true;
-        }
-        return false;
-    }
+    // The returned elements are this node's own, so an inherited list is
+    // copied into the instance before it is handed out.
+    bool getList(const std::string& key, std::vector<std::shared_ptr<ValueNode>>& out);
 
     template<typename T>
     bool getListElement(const std::string& key, size_t index, T& out){
-        std::vector<std::shared_ptr<ValueNode>> list;
-        if(getList(key, list) && index < list.size()){
-            if(std::holds_alternative<T>(list[index]->value)){
+        const Value* v = findProperty(key);
+        if(v && std::holds_alternative<std::vector<std::shared_ptr<ValueNode>>>(*v)){
+            auto& list = std::get<std::vector<std::shared_ptr<ValueNode>>>(*v);
+            if(index < list.size() && std::holds_alternative<T>(list[index]->value)){
                 out = std::get<T>(list[index]->value);
                 return true;
             }
@@ -101,26 +143,61 @@ struct Node {
         return false;
     }
 
+    // Turns an instance into a standalone node: inherited properties are
+    // copied in (overrides win) and the prefab's children are deep-copied
+    // after the instance's own, matching lookup order. No-op for regular
+    // nodes.
+    void detach();
+
+    // Deep copy of this node, its own children and its list values. Nested
+    // instances keep sharing their prefab.
+    NodePtr clone() const;
+
 private:
-    NodePtr findChildByLocalID(const std::vector<NodePtr>& nodeList, int localID, const std::string& nodeType){
-        for(auto& n: nodeList){
+    static NodePtr searchLocalID(const Node* parent, int localID, const std::string& nodeType){
+        for(auto& n: parent->children){
             if(n->type == nodeType && n->localID && *n->localID == localID) 
                 return n;
-            auto found = findChildByLocalID(n->children, localID, nodeType);
+            auto found = searchLocalID(n.get(), localID, nodeType);
             if(found) return found;
         }
-        return nullptr;
+        return parent->prefab ? searchLocalID(parent->prefab.get(), localID, nodeType) : nullptr;
+    }
+
+    static NodePtr resolveLocalID(Node* parent, int localID, const std::string& nodeType){
+        for(auto& n: parent->children){
+            if(n->type == nodeType && n->localID && *n->localID == localID) 
+                return n;
+            auto found = resolveLocalID(n.get(), localID, nodeType);
+            if(found) return found;
+        }
+        if(!parent->prefab || !searchLocalID(parent->prefab.get(), localID, nodeType)) return nullptr;
+        parent->detach();
+        return resolveLocalID(parent, localID, nodeType);
     }
 };
 
 struct Scene {
     std::vector<NodePtr> nodes;
+    // Template subtrees declared with `prefab`, in declaration order. They
+    // are not part of the tree and are not searched by getNodeByGlobalID.
+    std::vector<NodePtr> prefabs;
     
     NodePtr getNodeByName(const std::string& name){
         for(auto& n: nodes)
             if(n->name == name) return n;
         return nullptr;
     }
+
+    NodePtr getPrefab(const std::string& name){
+        for(auto& p: prefabs)
+            if(p->name == name) return p;
+        return nullptr;
+    }
+
+    void addPrefab(const NodePtr& prefab){
+        prefabs.push_back(prefab);
+    }
     
     NodePtr getNodeByGlobalID(int globalID){
         return findNodeByGlobalID(nodes, globalID);
@@ -143,5 +220,8 @@ private:
 
 namespace STDL {
 std::string valueToString(const Value& val);
+
+// Copy of val with list elements copied recursively instead of shared.
+Value deepCopy(const Value& val);
 }
 using ScenePtr = std::shared_ptr<Scene>;
\ No newline at end of file
@@ -0,0 +1,99 @@
+#include "stdl.hpp"
+#include <cstdio>
+#include <string>
+
+// ColumnQuery over a scene built in code: bool columns filled from several
+// threads, int/double widening, and owners() for rows inherited from a
+// prefab.
+
+namespace {
+
+int failures = 0;
+
+void expect(bool ok, const char* what){
+    if(!ok){
+        std::printf("FAIL %s\n", what);
+        ++failures;
+    }
+}
+
+NodePtr makeNode(const std::string& type, const std::string& name){
+    auto n = std::make_shared<Node>();
+    n->type = type;
+    n->name = name;
+    return n;
+}
+
+}
+
+int main(){
+    const int count = 997;
+
+    auto scene = std::make_shared<Scene>();
+    auto birch = makeNode("tree", "Birch");
+    birch->set("leaves", true);
+    birch->addChild(makeNode("branch", "Branch"));
+    scene->addPrefab(birch);
+
+    for(int i = 0; i < count; ++i){
+        auto tree = makeNode("tree", "Tree" + std::to_string(i));
+        if(i % 3 == 0){
+            tree->prefab = birch;
+        } else if(i % 3 == 1){
+            tree->set("leaves", false);
+            tree->set("height", i);
+        } else {
+            tree->set("leaves", std::string("maybe"));
+            tree->set("height", 0.5);
+        }
+        scene->addNode(tree);
+    }
+
+    for(unsigned threads : {1u, 4u, 0u}){
+        STDL::ColumnQuery query("tree");
+        auto& leaves = query.add<bool>("leaves");
+        auto& height = query.add<double>("height");
+        query.run(*scene, threads);
+
+        expect(query.rows().size() == static_cast<size_t>(count), "one row per tree");
+        bool ordered = true, leavesOk = true, heightOk = true;
+        for(int i = 0; i < count && i < static_cast<int>(query.rows().size()); ++i){
+            ordered = ordered && query.rows()[i]->name == "Tree" + std::to_string(i);
+            switch(i % 3){
+                case 0: leavesOk = leavesOk && leaves.valid[i] && leaves.values[i] == 1; break;
+                case 1: leavesOk = leavesOk && leaves.valid[i] && leaves.values[i] == 0; break;
+                default: leavesOk = leavesOk && !leaves.valid[i]; break;
+            }
+            switch(i % 3){
+                case 0: heightOk = heightOk && !height.valid[i]; break;
+                case 1: heightOk = heightOk && height.valid[i] && height.values[i] == i; break;
+                default: heightOk = heightOk && height.valid[i] && height.values[i] == 0.5; break;
+            }
+        }
+        expect(ordered, "rows keep scene order");
+        expect(leavesOk, "bool column values and validity");
+        expect(heightOk, "double column widens ints and rejects missing values");
+    }
+
+    STDL::ColumnQuery inherited("branch");
+    inherited.run(*scene, 4);
+    size_t instances = (count + 2) / 3;
+    expect(inherited.rows().size() == instances, "inherited branch once per instance by default");
+    bool ownersOk = inherited.owners().size() == inherited.rows().size();
+    for(size_t i = 0; ownersOk && i < inherited.rows().size(); ++i){
+        ownersOk = inherited.owners()[i] == scene->nodes[i * 3] && inherited.rows()[i] == birch->children[0];
+    }
+    expect(ownersOk, "owners() names the instance for each inherited row");
+
+    STDL::ColumnQuery skipped("branch");
+    skipped.skipInherited = true;
+    skipped.run(*scene, 4);
+    expect(skipped.rows().empty(), "skipInherited leaves out inherited children");
+
+    if(failures){
+        std::printf("%d failure(s)\n", failures);
+        return 1;
+    }
+    std::printf("columns: all checks passed\n");
+    return 0;
+}
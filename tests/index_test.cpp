@@ -0,0 +1,141 @@
+#include "stdl.hpp"
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+// Sidecar index: build/save/load round trip, LoadNode for top-level, nested
+// and prefab-instance blocks, ResolveIndexedRef, stale-file detection and
+// LoadIndex's strict header parsing.
+
+namespace {
+
+int failures = 0;
+
+void expect(bool ok, const char* what){
+    if(!ok){
+        std::printf("FAIL %s\n", what);
+        ++failures;
+    }
+}
+
+// The parser stores `key = value` as a one-element list.
+template<typename T>
+T prop(const Node& node, const std::string& key){
+    T out{};
+    const_cast<Node&>(node).getListElement(key, 0, out);
+    return out;
+}
+
+void writeFile(const std::string& path, const std::string& content){
+    std::ofstream file(path, std::ios::binary);
+    file << content;
+}
+
+bool sameEntry(const STDL::IndexEntry& a, const STDL::IndexEntry& b){
+    return a.globalID == b.globalID && a.type == b.type && a.name == b.name &&
+           a.offset == b.offset && a.length == b.length && a.hash == b.hash;
+}
+
+const char* kScene = R"(scene v1
+
+prefab tree Oak
+{
+    height = 1
+    node branch Branch
+    {
+        length = 2
+    }
+}
+
+node forest Woods @1
+{
+    target = <tree:Lone @3>
+    node tree Inner @2
+    {
+        height = 5
+    }
+}
+
+node tree Lone @3 from Oak
+{
+}
+)";
+
+}
+
+int main(){
+    const std::string path = "index_test.stdl";
+    const std::string indexPath = STDL::IndexPath(path);
+    writeFile(path, kScene);
+
+    STDL::SceneIndex index;
+    expect(STDL::BuildIndex(path, index), "BuildIndex");
+    expect(index.nodes.size() == 3, "every global ID indexed, nested ones included");
+    expect(index.prefabs.size() == 1, "prefab indexed");
+    expect(STDL::IndexIsCurrent(path, index), "fresh index is current");
+
+    // Round trip through the sidecar file.
+    expect(STDL::SaveIndex(index, indexPath), "SaveIndex");
+    STDL::SceneIndex loaded;
+    expect(STDL::LoadIndex(indexPath, loaded), "LoadIndex");
+    bool same = loaded.fileSize == index.fileSize && loaded.fileHash == index.fileHash &&
+                loaded.nodes.size() == index.nodes.size() && loaded.prefabs.size() == index.prefabs.size();
+    for(size_t i = 0; same && i < index.nodes.size(); ++i) same = sameEntry(loaded.nodes[i], index.nodes[i]);
+    for(size_t i = 0; same && i < index.prefabs.size(); ++i) same = sameEntry(loaded.prefabs[i], index.prefabs[i]);
+    expect(same, "index survives save and load");
+
+    auto woods = STDL::LoadNode(path, 1);
+    expect(woods && woods->name == "Woods", "LoadNode reads the sidecar index");
+    expect(woods && woods->findChild("Inner"), "top-level block keeps its children");
+
+    auto inner = STDL::LoadNode(path, loaded, 2);
+    expect(inner && inner->name == "Inner" && prop<int>(*inner, "height") == 5, "LoadNode for a nested node");
+
+    auto lone = STDL::LoadNode(path, loaded, 3);
+    expect(lone && lone->isInstance() && lone->prefab->name == "Oak", "LoadNode brings the prefab along");
+    expect(lone && prop<int>(*lone, "height") == 1 && lone->findChild("Branch"), "instance reads through its prefab");
+
+    expect(!STDL::LoadNode(path, loaded, 99), "unknown global ID");
+
+    if(woods){
+        Ref target;
+        woods->getListElement("target", 0, target);
+        auto resolved = STDL::ResolveIndexedRef(path, loaded, target);
+        expect(resolved && resolved->name == "Lone", "ResolveIndexedRef loads the target block");
+    }
+    Ref local;
+    local.localID = 1;
+    expect(!STDL::ResolveIndexedRef(path, loaded, local), "local refs are not resolved through the index");
+
+    // Same-size edit inside Inner's block: the file size still matches, the
+    // hashes don't.
+    std::string edited = kScene;
+    edited.replace(edited.find("height = 5"), 10, "height = 6");
+    writeFile(path, edited);
+    expect(!STDL::IndexIsCurrent(path, loaded), "same-size edit makes the index stale");
+    expect(!STDL::LoadNode(path, loaded, 2), "edited block is not loaded");
+    expect(STDL::LoadNode(path, loaded, 3) != nullptr, "untouched blocks still load");
+
+    // The size and hash lines are required and must parse.
+    STDL::SceneIndex rejected;
+    writeFile(indexPath, "stdl-index v1\nhash 1f\n");
+    expect(!STDL::LoadIndex(indexPath, rejected), "missing size line rejected");
+    writeFile(indexPath, "stdl-index v1\nsize 12\n");
+    expect(!STDL::LoadIndex(indexPath, rejected), "missing hash line rejected");
+    writeFile(indexPath, "stdl-index v1\nsize twelve\nhash 1f\n");
+    expect(!STDL::LoadIndex(indexPath, rejected), "malformed size rejected");
+    writeFile(indexPath, "stdl-index v1\nsize 12\nhash zz\n");
+    expect(!STDL::LoadIndex(indexPath, rejected), "malformed hash rejected");
+    writeFile(indexPath, "stdl-index v2\nsize 12\nhash 1f\n");
+    expect(!STDL::LoadIndex(indexPath, rejected), "unknown version rejected");
+
+    std::remove(path.c_str());
+    std::remove(indexPath.c_str());
+
+    if(failures){
+        std::printf("%d failure(s)\n", failures);
+        return 1;
+    }
+    std::printf("index: all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,170 @@
+#include "stdl.hpp"
+#include <cstdio>
+#include <string>
+
+// Prefabs: parsing `prefab`/`from`, override precedence along a prefab
+// chain, copy-on-access for every mutable accessor, ToString round trips
+// and the parse errors.
+
+namespace {
+
+int failures = 0;
+
+void expect(bool ok, const char* what){
+    if(!ok){
+        std::printf("FAIL %s\n", what);
+        ++failures;
+    }
+}
+
+// The parser stores `key = value` as a one-element list.
+template<typename T>
+T prop(const Node& node, const std::string& key){
+    T out{};
+    const_cast<Node&>(node).getListElement(key, 0, out);
+    return out;
+}
+
+const char* kScene = R"(scene v1
+
+prefab tree Oak
+{
+    height = 1
+    kind = "oak"
+    pos = [1.0, 2.0]
+    node branch Branch
+    {
+        length = 2
+    }
+    node tree Sapling #1
+    {
+        age = 1
+    }
+}
+
+prefab tree BigOak from Oak
+{
+    height = 2
+}
+
+node forest Woods @1
+{
+    node tree A @10 from BigOak { kind = "a" }
+    node tree B @11 from BigOak { }
+    node tree C @12 from Oak // planted from seed
+    {
+    }
+    node tree D @13 // grown from nothing
+    {
+        height = 4
+    }
+}
+)";
+
+}
+
+int main(){
+    auto scene = STDL::LoadString(kScene);
+    expect(scene != nullptr, "scene with prefabs parses");
+    if(!scene){
+        std::printf("%d failure(s)\n", failures);
+        return 1;
+    }
+
+    auto oak = scene->getPrefab("Oak");
+    auto bigOak = scene->getPrefab("BigOak");
+    expect(oak && bigOak && scene->prefabs.size() == 2, "prefabs registered in order");
+    expect(bigOak && bigOak->prefab == oak, "prefab built from another prefab");
+    expect(scene->nodes.size() == 1, "prefabs are not scene nodes");
+
+    auto a = scene->getNodeByGlobalID(10);
+    auto b = scene->getNodeByGlobalID(11);
+    auto c = scene->getNodeByGlobalID(12);
+    auto d = scene->getNodeByGlobalID(13);
+    expect(a && b && c && d, "instances found by global ID");
+    if(!a || !b || !c || !d || !oak || !bigOak){
+        std::printf("%d failure(s)\n", failures);
+        return 1;
+    }
+    auto oakBranch = oak->getChild("Branch");
+    auto oakSapling = oak->getChild("Sapling");
+
+    // Precedence: own override, then the nearest prefab, then its base.
+    expect(prop<int>(*a, "height") == 2 && prop<std::string>(*a, "kind") == "a", "instance override wins");
+    expect(prop<int>(*b, "height") == 2 && prop<std::string>(*b, "kind") == "oak", "nearest prefab beats its base");
+    expect(prop<int>(*c, "height") == 1, "direct instance reads its prefab");
+    expect(!d->isInstance() && prop<int>(*d, "height") == 4, "'from' in a header comment is ignored");
+    expect(c->prefab == oak, "'from' before a header comment is honoured");
+    expect(a->findChild("Branch") == oakBranch, "findChild shares the prefab's child");
+
+    // ToString keeps the sharing and parses back.
+    std::string text = STDL::ToString(scene);
+    expect(text.find("prefab tree BigOak from Oak") != std::string::npos, "ToString writes prefab chains");
+    expect(text.find("node tree C @12 from Oak") != std::string::npos, "ToString writes instances with 'from'");
+    auto again = STDL::LoadString(text);
+    expect(again != nullptr, "ToString output parses");
+    if(again){
+        auto c2 = again->getNodeByGlobalID(12);
+        expect(c2 && c2->isInstance() && c2->prefab->name == "Oak", "round trip keeps the instance");
+        expect(c2 && prop<int>(*c2, "height") == 1, "round trip keeps inherited values");
+        expect(c2 && c2->properties.empty(), "round trip does not materialize the instance");
+    }
+
+    std::vector<std::shared_ptr<ValueNode>> list;
+
+    // getList copies an inherited list into the instance.
+    expect(b->getList("pos", list) && !list.empty(), "getList on an instance");
+    if(!list.empty()) list[0]->value = 99.0;
+    expect(prop<double>(*oak, "pos") == 1.0, "getList edit leaves the prefab alone");
+    expect(prop<double>(*a, "pos") == 1.0, "getList edit leaves sibling instances alone");
+    expect(b->isInstance(), "getList does not detach");
+
+    // get<T> on a list goes through the same copy.
+    list.clear();
+    expect(c->get("pos", list) && !list.empty(), "get<list> on an instance");
+    if(!list.empty()) list[0]->value = 42.0;
+    expect(prop<double>(*oak, "pos") == 1.0, "get<list> edit leaves the prefab alone");
+
+    // Read-only ref resolution keeps the sharing.
+    Ref local;
+    local.localID = 1;
+    expect(b->resolveRef(local, scene.get()) == oakSapling, "resolveRef finds the inherited child");
+    expect(b->isInstance(), "resolveRef does not detach");
+
+    // Mutable lookups detach and hand out the instance's own copy.
+    auto aBranch = a->getChild("Branch");
+    expect(aBranch && aBranch != oakBranch && !a->isInstance(), "getChild detaches");
+    if(aBranch) aBranch->set("length", 9);
+    expect(prop<int>(*oakBranch, "length") == 2, "getChild edit leaves the prefab alone");
+    expect(b->findChild("Branch") == oakBranch, "getChild edit leaves sibling instances alone");
+    expect(prop<int>(*a, "height") == 2 && prop<std::string>(*a, "kind") == "a", "detach keeps effective values");
+
+    auto bSapling = b->getRefTarget(local, scene.get());
+    expect(bSapling && bSapling != oakSapling && !b->isInstance(), "getRefTarget detaches");
+    if(bSapling) bSapling->set("age", 5);
+    expect(prop<int>(*oakSapling, "age") == 1, "getRefTarget edit leaves the prefab alone");
+
+    auto e = std::make_shared<Node>();
+    e->type = "tree";
+    e->name = "E";
+    e->prefab = oak;
+    e->detach();
+    list.clear();
+    expect(e->getList("pos", list) && !list.empty(), "detached node owns its list");
+    if(!list.empty()) list[0]->value = 7.0;
+    expect(prop<double>(*oak, "pos") == 1.0, "detach deep-copies list values");
+    expect(prop<double>(*c, "pos") == 1.0, "detach edit leaves instances alone");
+
+    // Parse errors.
+    expect(!STDL::LoadString("scene v1\nnode tree X from Nope { }\n"), "unknown prefab rejected");
+    expect(!STDL::LoadString("scene v1\nprefab tree P { }\nprefab tree P { }\n"), "duplicate prefab rejected");
+    expect(!STDL::LoadString("scene v1\nprefab tree P @5 { }\n"), "global ID on a prefab rejected");
+    expect(!STDL::LoadString("scene v1\nprefab tree P\n{\n    node leaf L @5 { }\n}\n"), "global ID inside a prefab rejected");
+
+    if(failures){
+        std::printf("%d failure(s)\n", failures);
+        return 1;
+    }
+    std::printf("prefabs: all checks passed\n");
+    return 0;
+}
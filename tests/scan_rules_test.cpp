@@ -0,0 +1,126 @@
+#include "parser.hpp"
+#include "stdl.hpp"
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+// Checks that the scanner-backed grammar rules consume exactly what the
+// character-at-a-time rules they replaced did, on both the eager input the
+// parser used to run on and the lazy one it uses now.
+
+namespace pegtl = TAO_PEGTL_NAMESPACE;
+namespace grammar = STDLParser::grammar;
+
+namespace {
+
+int failures = 0;
+
+struct Match {
+    bool ok;
+    size_t consumed;
+};
+
+template<typename Rule, pegtl::tracking_mode M>
+Match run(const std::string& text){
+    pegtl::memory_input<M> in(text.data(), text.size(), "test");
+    const char* begin = in.current();
+    bool ok = pegtl::parse<Rule>(in);
+    return { ok, static_cast<size_t>(in.current() - begin) };
+}
+
+std::string show(const std::string& text){
+    std::string out;
+    for(char c : text){
+        switch(c){
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default: out += c; break;
+        }
+    }
+    return out;
+}
+
+template<typename Old, typename New>
+void compare(const char* label, const std::string& text){
+    Match expected = run<Old, pegtl::tracking_mode::eager>(text);
+    Match eager = run<New, pegtl::tracking_mode::eager>(text);
+    Match lazy = run<New, pegtl::tracking_mode::lazy>(text);
+    if(eager.ok != expected.ok || eager.consumed != expected.consumed ||
+       lazy.ok != expected.ok || lazy.consumed != expected.consumed){
+        std::printf("FAIL %s \"%s\": expected %d/%zu, got %d/%zu (eager) %d/%zu (lazy)\n",
+            label, show(text).c_str(), expected.ok, expected.consumed,
+            eager.ok, eager.consumed, lazy.ok, lazy.consumed);
+        ++failures;
+    }
+}
+
+void compareAll(const std::string& text){
+    compare<grammar::reference::opt_ws, grammar::opt_ws>("opt_ws", text);
+    compare<grammar::reference::ws_or_comment, grammar::ws_or_comment>("ws_or_comment", text);
+    compare<pegtl::star<grammar::reference::ws_or_comment>, pegtl::star<grammar::ws_or_comment>>("star<ws_or_comment>", text);
+    compare<grammar::reference::string_content, grammar::string_content>("string_content", text);
+}
+
+void expectParse(const char* label, const std::string& text, bool ok){
+    Scene scene;
+    if(STDLParser::ParseSTDL(text, scene) != ok){
+        std::printf("FAIL %s: expected ParseSTDL to %s\n", label, ok ? "succeed" : "fail");
+        ++failures;
+    }
+}
+
+}
+
+int main(){
+    const std::vector<std::string> cases = {
+        "",
+        " ",
+        "x",
+        "/",
+        "//",
+        "/ /",
+        "// no newline at eof",
+        "//\n",
+        "//\r\n  x",
+        "// lone \r carriage return\nx",
+        "  \t\v\f\r\n// a\n   // b\n\n}",
+        "   /x",
+        std::string(40, ' ') + "//" + std::string(40, 'c') + "\n" + std::string(33, '\t') + "z",
+        "plain text\"",
+        "esc \\\" quote\"",
+        "esc \\\\\"",
+        "bad \\q escape\"",
+        "trailing backslash \\",
+        "\\n\\t\\r\\\"\\\\",
+        std::string(31, 'a') + "\\\"" + std::string(17, 'b') + "\"",
+        std::string(64, 'a'),
+        "\xc3\xa9\xe2\x82\xac utf-8 \"",
+        std::string("embedded\0nul\"", 13),
+    };
+    for(auto& text : cases) compareAll(text);
+
+    // Random mixes of the bytes the rules care about, long enough to cross
+    // several 16/32-byte blocks.
+    std::mt19937 rng(2026);
+    const char alphabet[] = " \t\r\n\v\f/\"\\ntrxq\x80\xff";
+    for(int i = 0; i < 20000; ++i){
+        std::string text(rng() % 130, ' ');
+        for(auto& c : text) c = alphabet[rng() % (sizeof(alphabet) - 1)];
+        compareAll(text);
+    }
+
+    expectParse("comment at eof", "scene v1\nnode a A @1 { x = 1 } // end", true);
+    expectParse("crlf", "scene v1\r\n// c\r\nnode a A @1\r\n{\r\n  x = \"a\\\"b\" // c\r\n}\r\n", true);
+    expectParse("comments in list", "scene v1\nnode a A { l = [ 1, // one\n 2 // two\n ] }", true);
+    expectParse("bad escape", "scene v1\nnode a A { s = \"a\\qb\" }", false);
+    expectParse("unterminated string", "scene v1\nnode a A { s = \"abc }", false);
+
+    if(failures){
+        std::printf("%d failure(s)\n", failures);
+        return 1;
+    }
+    std::printf("scan rules: all cases match (%s)\n", STDLParser::scan::backendName());
+    return 0;
+}